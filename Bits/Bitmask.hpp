@@ -4,7 +4,15 @@
 
 #include <cstdint>
 #include <cassert>
-#include <cmath>
+#include <bit>
+#include <type_traits>
+#include <utility>
+#include <limits>
+#include <atomic>
+#include <stdexcept>
+#include <algorithm>
+#include <span>
+#include <iterator>
 
 namespace bitmask
 {
@@ -20,6 +28,42 @@ constexpr uint64_t static_power_2(auto N)
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/// <summary>
+/// Reverse the order of the bytes in value. This is constexpr, so that masks can be converted to wire order at compile-time. The bytes
+/// are moved by a fixed set of masks and shifts, which compilers recognise as a single byte-swap instruction, and can vectorise.
+/// </summary>
+template<typename Value_T>
+constexpr Value_T ByteSwap(Value_T value)
+{
+    static_assert(std::is_integral_v<Value_T> && std::is_unsigned_v<Value_T>, "Only unsigned integral values can be byte-swapped");
+
+    return [value]<size_t... BYTE>(std::index_sequence<BYTE...>) {
+        return static_cast<Value_T>(((static_cast<Value_T>((value >> (WORD_SIZE * BYTE)) & 0xFF) << (WORD_SIZE * (sizeof(Value_T) - 1 - BYTE))) | ...));
+    }(std::make_index_sequence<sizeof(Value_T)>{});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// The byte order of the values of a register as they appear on the bus. Registers that don't declare a "byte_order" member are
+/// assumed to be in the native byte order of the host.
+/// </summary>
+/// <typeparam name="Register_T">The register type to get the byte order of.</typeparam>
+template<typename Register_T>
+struct ByteOrder
+{
+    static constexpr std::endian value = std::endian::native;
+};
+
+template<typename Register_T>
+    requires requires { Register_T::byte_order; }
+struct ByteOrder<Register_T>
+{
+    static constexpr std::endian value = Register_T::byte_order;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 /// <summary>
 /// A Mask has a "value" member with type Value_T with the lowest SIZE bits set.
 /// </summary>
@@ -74,7 +118,8 @@ struct Shift
 template<typename Register_T, uint8_t LOWEST_BIT, uint8_t HIGHEST_BIT>
 struct Bitrange
 {
-    using Value_t = typename Register_T::Value_t;
+    using Register_t = Register_T;
+    using Value_t    = typename Register_T::Value_t;
 
     static_assert(LOWEST_BIT < WORD_SIZE * sizeof(Value_t), "First bit of bitmask is outside value range");
     static_assert(HIGHEST_BIT < WORD_SIZE * sizeof(Value_t), "Last bit of bitmask is outside value range");
@@ -84,9 +129,26 @@ struct Bitrange
     static constexpr uint8_t highest_bit = HIGHEST_BIT;
     static constexpr uint8_t size        = 1 + highest_bit - lowest_bit;
 
-    static constexpr auto max() { return static_power_2(size) - 1; }
+    /// The largest value that fits in the range.
+    static constexpr uint64_t max_value = static_power_2(size) - 1;
+
+    static constexpr auto max() { return max_value; }
 
     static constexpr Value_t mask = Shift<Value_t, Mask<Value_t, 1 + highest_bit - lowest_bit>::value, lowest_bit>::value;
+
+    /// Whether the register holds its values in the opposite byte order to the host, and so needs its bytes reversing on the wire.
+    static constexpr bool is_byte_swapped = sizeof(Value_t) > 1 && ByteOrder<Register_T>::value != std::endian::native;
+
+    /// The mask for this range, as applied to a value in the byte order that it appears on the bus.
+    static constexpr Value_t wire_mask = is_byte_swapped ? ByteSwap(mask) : mask;
+
+    /// Whether the bits in the range are still adjacent in wire order. If they are, then the value can be masked and shifted directly
+    /// from the wire-order value, without swapping the whole value first.
+    static constexpr bool is_wire_contiguous = !is_byte_swapped || (lowest_bit / WORD_SIZE == highest_bit / WORD_SIZE);
+
+    /// The position of the lowest bit of the range in the wire-order value. Only meaningful when is_wire_contiguous is true.
+    static constexpr uint8_t wire_lowest_bit
+        = is_byte_swapped ? (sizeof(Value_t) - 1 - lowest_bit / WORD_SIZE) * WORD_SIZE + lowest_bit % WORD_SIZE : lowest_bit;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -102,6 +164,99 @@ struct SingleBit : public Bitrange<Register_T, BIT, BIT>
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/// <summary>
+/// Range policy that passes values through unchanged. Any bits of the value that don't fit in the range are dropped when it is set.
+/// </summary>
+struct Unchecked
+{
+    template<typename Range_T, typename Value_T>
+    static constexpr Value_T apply(Value_T val)
+    {
+        return val;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Range policy that asserts that the value fits in the range. This is only checked in debug builds.
+/// </summary>
+struct AssertInRange
+{
+    template<typename Range_T, typename Value_T>
+    static constexpr Value_T apply(Value_T val)
+    {
+        [[maybe_unused]] constexpr auto max_val = static_cast<Value_T>(Range_T::max_value);
+
+        assert(val <= max_val);
+        return val;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Range policy that clamps values that are too large for the range to the largest value that the range can hold.
+/// </summary>
+struct Saturate
+{
+    template<typename Range_T, typename Value_T>
+    static constexpr Value_T apply(Value_T val)
+    {
+        constexpr auto max_val = static_cast<Value_T>(Range_T::max_value);
+
+        return std::min(val, max_val);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Range policy that keeps only the bits of the value that fit in the range, and keeps a count of the number of values that didn't fit.
+/// </summary>
+struct TruncateAndCount
+{
+    /// The number of values that didn't fit in Range_T.
+    template<typename Range_T>
+    static inline std::atomic<uint64_t> count{0};
+
+    template<typename Range_T, typename Value_T>
+    static Value_T apply(Value_T val)
+    {
+        constexpr auto max_val = static_cast<Value_T>(Range_T::max_value);
+
+        if (val > max_val)
+        {
+            count<Range_T>.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return val & max_val;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Range policy that throws std::out_of_range if the value doesn't fit in the range.
+/// </summary>
+struct ThrowOutOfRange
+{
+    template<typename Range_T, typename Value_T>
+    static constexpr Value_T apply(Value_T val)
+    {
+        constexpr auto max_val = static_cast<Value_T>(Range_T::max_value);
+
+        if (val > max_val)
+        {
+            throw std::out_of_range("Value will not fit in allocated register bits");
+        }
+
+        return val;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 /// <summary>
 /// Extract the value in the specified bit range from the provided register value.
 /// </summary>
@@ -122,12 +277,13 @@ Value_T GetValue(Value_T register_val)
 /// </summary>
 /// <typeparam name="Range_T">The range type that will be used to determine which bits in register_val are set.</typeparam>
 /// <typeparam name="Value_T">The target value type.</typeparam>
+/// <typeparam name="Policy_T">The policy applied to values that don't fit in the range (e.g. Saturate).</typeparam>
 /// <param name="register_val">The value that will contain the final bit values.</param>
 /// <param name="val">The value to set into the specified bits of register_val</param>
-template<typename Range_T, typename Value_T>
+template<typename Range_T, typename Value_T, typename Policy_T = AssertInRange>
 void SetValue(Value_T& register_val, Value_T val)
 {
-    assert(val <= std::powl(2, Range_T::size));
+    val = Policy_T::template apply<Range_T>(val);
 
     register_val &= ~Range_T::mask;
     register_val |= (val << Range_T::lowest_bit) & Range_T::mask;
@@ -136,7 +292,58 @@ void SetValue(Value_T& register_val, Value_T val)
 ///////////////////////////////////////////////////////////////////////////////
 
 /// <summary>
-/// Allows easy access to the individual bit values and ranges of bits.
+/// Extract the value in the specified bit range from a register value that is in the byte order that it has on the bus.
+/// </summary>
+/// <typeparam name="Range_T">The range type that will be used to mask wire_val to get the result.</typeparam>
+/// <typeparam name="Value_T">The target value type.</typeparam>
+/// <param name="wire_val">The value, in wire order, that contains the bits from which to extract the result.</param>
+/// <returns>The value stored in the specified bits of wire_val, in host byte order.</returns>
+template<typename Range_T, typename Value_T>
+Value_T GetWireValue(Value_T wire_val)
+{
+    if constexpr (Range_T::is_wire_contiguous)
+    {
+        return (wire_val & Range_T::wire_mask) >> Range_T::wire_lowest_bit;
+    }
+    else
+    {
+        return GetValue<Range_T, Value_T>(ByteSwap(wire_val));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Set the value into the specified bits of a register value that is in the byte order that it has on the bus.
+/// </summary>
+/// <typeparam name="Range_T">The range type that will be used to determine which bits in wire_val are set.</typeparam>
+/// <typeparam name="Value_T">The target value type.</typeparam>
+/// <typeparam name="Policy_T">The policy applied to values that don't fit in the range (e.g. Saturate).</typeparam>
+/// <param name="wire_val">The value, in wire order, that will contain the final bit values.</param>
+/// <param name="val">The value, in host byte order, to set into the specified bits of wire_val</param>
+template<typename Range_T, typename Value_T, typename Policy_T = AssertInRange>
+void SetWireValue(Value_T& wire_val, Value_T val)
+{
+    val = Policy_T::template apply<Range_T>(val);
+
+    if constexpr (Range_T::is_wire_contiguous)
+    {
+        wire_val &= ~Range_T::wire_mask;
+        wire_val |= (val << Range_T::wire_lowest_bit) & Range_T::wire_mask;
+    }
+    else
+    {
+        auto host_val = ByteSwap(wire_val);
+        SetValue<Range_T, Value_T, Unchecked>(host_val, val);
+        wire_val = ByteSwap(host_val);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Allows easy access to the individual bit values and ranges of bits. The bits are held in the byte order that the register has on the
+/// bus, so the raw value can be passed to and from the hardware unchanged.
 /// </summary>
 /// <typeparam name="Register_T">The type of the register to be accessed</typeparam>
 template<typename Register_T>
@@ -154,6 +361,19 @@ public:
     const Value_t& raw() const { return m_bits; }
     Value_t& raw() { return m_bits; }
 
+    /// The register value in host byte order.
+    Value_t value() const
+    {
+        if constexpr (sizeof(Value_t) > 1 && ByteOrder<Register_T>::value != std::endian::native)
+        {
+            return ByteSwap(m_bits);
+        }
+        else
+        {
+            return m_bits;
+        }
+    }
+
 #if (__cplusplus >= 201703L)
     template<typename BitRange_T, typename Result_T = Value_t>
     auto get() const
@@ -161,12 +381,13 @@ public:
         if constexpr (BitRange_T::lowest_bit != BitRange_T::highest_bit)
         {
             static_assert(std::is_integral_v<Result_T>, "Result of a resister::get must be an integral type");
+            static_assert(std::numeric_limits<Result_T>::digits >= BitRange_T::size, "Result type is too narrow to hold the bit range");
 
-            return static_cast<Result_T>(bitmask::GetValue<BitRange_T, Value_t>(m_bits));
+            return static_cast<Result_T>(bitmask::GetWireValue<BitRange_T, Value_t>(m_bits));
         }
         else
         {
-            return bitmask::GetValue<BitRange_T, Result_T>(m_bits) != 0;
+            return bitmask::GetWireValue<BitRange_T, Result_T>(m_bits) != 0;
         }
     }
 #else
@@ -180,44 +401,46 @@ public:
     std::enable_if_t<BitRange_T::lowest_bit != BitRange_T::highest_bit, Result_T> get() const
     {
         static_assert(std::is_integral<Result_T>::value, "Result of a resister::get must be an integral type");
+        static_assert(std::numeric_limits<Result_T>::digits >= BitRange_T::size, "Result type is too narrow to hold the bit range");
 
-        return static_cast<Result_T>(bitmask::GetValue<BitRange_T, Value_t>(m_bits));
+        return static_cast<Result_T>(bitmask::GetWireValue<BitRange_T, Value_t>(m_bits));
     }
 
     /// Get the value of the bits defined by BitRange_T.  This version is called when the Range is exactly one bit wide.
     template<typename BitRange_T>
     std::enable_if_t<BitRange_T::lowest_bit == BitRange_T::highest_bit, bool> get() const
     {
-        return bitmask::GetValue<BitRange_T, Value_t>(m_bits) != 0;
+        return bitmask::GetWireValue<BitRange_T, Value_t>(m_bits) != 0;
     }
 #endif
 
 #if (__cplusplus >= 201703L)
-    template<typename BitRange_T>
+    /// Set the value of the bits defined by BitRange_T. Policy_T determines what happens to values that don't fit in the range.
+    template<typename BitRange_T, typename Policy_T = AssertInRange>
     void set(typename BitRange_T::Value_t value_to_set)
     {
         if constexpr (BitRange_T::lowest_bit != BitRange_T::highest_bit)
         {
-            bitmask::SetValue<BitRange_T, Value_t>(m_bits, value_to_set);
+            bitmask::SetWireValue<BitRange_T, Value_t, Policy_T>(m_bits, value_to_set);
         }
         else
         {
-            bitmask::SetValue<BitRange_T, Value_t>(m_bits, value_to_set ? 1 : 0);
+            bitmask::SetWireValue<BitRange_T, Value_t, Unchecked>(m_bits, value_to_set ? 1 : 0);
         }
     }
 #else
     /// Set the value of the bits defined by BitRange_T.  This version is called when the Range is more than one bit wide.
-    template<typename BitRange_T>
+    template<typename BitRange_T, typename Policy_T = AssertInRange>
     void set(std::enable_if_t<BitRange_T::lowest_bit != BitRange_T::highest_bit, Value_t> value_to_set)
     {
-        bitmask::SetValue<BitRange_T, Value_t>(m_bits, value_to_set);
+        bitmask::SetWireValue<BitRange_T, Value_t, Policy_T>(m_bits, value_to_set);
     }
 
     /// Set the value of the bits defined by BitRange_T.  This version is called when the Range is exactly one bit wide.
-    template<typename BitRange_T>
+    template<typename BitRange_T, typename Policy_T = AssertInRange>
     void set(std::enable_if_t<BitRange_T::lowest_bit == BitRange_T::highest_bit, bool> bit_value)
     {
-        bitmask::SetValue<BitRange_T, Value_t>(m_bits, bit_value ? 1 : 0);
+        bitmask::SetWireValue<BitRange_T, Value_t, Unchecked>(m_bits, bit_value ? 1 : 0);
     }
 #endif
 
@@ -229,7 +452,8 @@ public:
             static_assert(VALUE <= BitRange_T::max(), "specified value will not fit in allocated register bits");
         }
 
-        this->set<BitRange_T>(VALUE);
+        // The value has already been checked at compile-time.
+        this->set<BitRange_T, Unchecked>(VALUE);
     }
 
 private:
@@ -238,6 +462,79 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/// <summary>
+/// Packs the values of several bit ranges of the same register into many register values at once. The values for each range are
+/// supplied as a separate array, and the masks and shifts are all compile-time constants, so the loop over the register values has no
+/// branches and can be vectorised by the compiler.
+/// </summary>
+/// <typeparam name="Range_T">The first of the bit ranges to pack.</typeparam>
+/// <typeparam name="Ranges_T">The rest of the bit ranges to pack. These must all be in the same register as Range_T.</typeparam>
+template<typename Range_T, typename... Ranges_T>
+struct Encoder
+{
+    using Register_t = typename Range_T::Register_t;
+    using Value_t    = typename Range_T::Value_t;
+
+    static_assert((std::is_same_v<Register_t, typename Ranges_T::Register_t> && ...), "All the bit ranges must be in the same register");
+
+    /// <summary>
+    /// Pack the values of the bit ranges into out, in the byte order of the register on the bus.
+    /// </summary>
+    /// <typeparam name="Policy_T">The policy applied to values that don't fit in their range (e.g. Saturate).</typeparam>
+    /// <param name="out">The register values to fill. Bits that aren't in any of the ranges are set to zero.</param>
+    /// <param name="inputs">One contiguous array of values per bit range, in the same order as the ranges. Each must be at least as long as out.</param>
+    /// <returns>out, so that it can be passed straight on to a bulk writer.</returns>
+    template<typename Policy_T = AssertInRange, typename... Inputs_T>
+    static std::span<Value_t> encode(std::span<Value_t> out, const Inputs_T&... inputs)
+    {
+        static_assert(sizeof...(Inputs_T) == 1 + sizeof...(Ranges_T), "There must be one input per bit range");
+        assert(((std::size(inputs) >= out.size()) && ...));
+
+        encode<Policy_T, Range_T, Ranges_T...>(out.data(), out.size(), std::data(inputs)...);
+
+        return out;
+    }
+
+private:
+    template<typename Policy_T, typename... AllRanges_T, typename... Elements_T>
+    static void encode(Value_t* out, size_t count, const Elements_T*... inputs)
+    {
+        for (auto i = size_t{0}; i < count; ++i)
+        {
+            const auto value = static_cast<Value_t>((pack<Policy_T, AllRanges_T>(inputs[i]) | ...));
+
+            if constexpr (Range_T::is_byte_swapped)
+            {
+                out[i] = ByteSwap(value);
+            }
+            else
+            {
+                out[i] = value;
+            }
+        }
+    }
+
+    /// Shift a single value into the position of its range. As with set(), any non-zero value sets a single-bit range. The range policy
+    /// is applied before inputs that are wider than the register are narrowed, so that it sees the bits that wouldn't fit.
+    template<typename Policy_T, typename BitRange_T, typename Element_T>
+    static constexpr Value_t pack(Element_T input)
+    {
+        if constexpr (BitRange_T::lowest_bit == BitRange_T::highest_bit)
+        {
+            return static_cast<Value_t>(static_cast<Value_t>(input != 0) << BitRange_T::lowest_bit);
+        }
+        else
+        {
+            using Wide_t = std::conditional_t<(sizeof(Element_T) > sizeof(Value_t)), Element_T, Value_t>;
+
+            const auto value = static_cast<Value_t>(Policy_T::template apply<BitRange_T>(static_cast<Wide_t>(input)));
+            return static_cast<Value_t>((value << BitRange_T::lowest_bit) & BitRange_T::mask);
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 } // namespace bitmask
 
 ///////////////////////////////////////////////////////////////////////////////
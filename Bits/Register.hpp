@@ -6,6 +6,8 @@
 
 #include <type_traits>
 #include <functional>
+#include <array>
+#include <bit>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -28,14 +30,88 @@ public:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/// <summary>
+/// The order in which the bus-sized words of a register that is wider than its bus are accessed. Hardware that latches the rest of a
+/// wide value when one half of it is read (or commits it when one half is written) needs these accesses to happen in a specific order.
+/// </summary>
+enum class WordOrder
+{
+    least_significant_first,
+    most_significant_first
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Describes how the value of a register is moved over the bus. By default, this is a single access of the full width of the register.
+/// </summary>
+/// <typeparam name="Register_T">The type of the register to be accessed</typeparam>
+template<typename Register_T>
+struct BusAccess
+{
+    using Value_t = typename Register_T::Value_t;
+    using Bus_t   = Value_t;
+
+    using Reader = std::function<Value_t()>;
+    using Writer = std::function<void(Value_t)>;
+
+    static constexpr size_t count = 1;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Registers that are wider than their bus are moved in "count" bus-sized accesses. The reader and writer are given the address of each
+/// access, which steps through the register in units of the bus width.
+/// </summary>
+/// <typeparam name="Register_T">The type of the register to be accessed</typeparam>
+template<typename Register_T>
+    requires(sizeof(typename Register_T::Bus_t) < sizeof(typename Register_T::Value_t))
+struct BusAccess<Register_T>
+{
+    using Value_t   = typename Register_T::Value_t;
+    using Bus_t     = typename Register_T::Bus_t;
+    using Address_t = typename Register_T::Offset_t;
+
+    using Reader = std::function<Bus_t(Address_t)>;
+    using Writer = std::function<void(Address_t, Bus_t)>;
+
+    static constexpr size_t count = sizeof(Value_t) / sizeof(Bus_t);
+
+    /// The bit position, in the wire-order register value, of the word at the n-th bus address of the register.
+    static constexpr uint8_t shift(size_t n)
+    {
+        return static_cast<uint8_t>(bitmask::WORD_SIZE * sizeof(Bus_t) * (std::endian::native == std::endian::little ? n : count - 1 - n));
+    }
+
+    /// The index of the bus address of each access, in the order that the accesses are made.
+    static constexpr std::array<size_t, count> sequence = []() {
+        // The most significant word of a big-endian register is at its lowest address.
+        constexpr auto is_big_endian = bitmask::ByteOrder<Register_T>::value == std::endian::big;
+        constexpr auto is_ascending  = is_big_endian == (Register_T::word_order == WordOrder::most_significant_first);
+
+        auto out = std::array<size_t, count>{};
+        for (auto i = size_t{0}; i < count; ++i)
+        {
+            out[i] = is_ascending ? i : count - 1 - i;
+        }
+
+        return out;
+    }();
+
+    static constexpr Address_t address(size_t n) { return static_cast<Address_t>(Register_T::address + n * sizeof(Bus_t)); }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 template<typename Register_T>
 class Register : public bitmask::BitRangeAccessor<Register_T>
 {
 public:
     using Value_t = typename bitmask::BitRangeAccessor<Register_T>::Value_t;
 
-    using Reader = std::function<Value_t()>;
-    using Writer = std::function<void(Value_t)>;
+    using Reader = typename BusAccess<Register_T>::Reader;
+    using Writer = typename BusAccess<Register_T>::Writer;
 
     Register(Reader getter, Writer setter, Value_t initial_value = Value_t{})
         : bitmask::BitRangeAccessor<Register_T>{initial_value}
@@ -47,19 +123,49 @@ public:
     auto write(Value_t value) -> decltype(*this)&
     {
         this->raw() = value;
-        return this->write();
+        this->write();
+
+        return *this;
     }
 
     auto write() const -> decltype(*this)&
     {
-        m_writer(this->raw());
+        using Access_t = BusAccess<Register_T>;
+
+        if constexpr (Access_t::count == 1)
+        {
+            m_writer(this->raw());
+        }
+        else
+        {
+            for (const auto n : Access_t::sequence)
+            {
+                m_writer(Access_t::address(n), static_cast<typename Access_t::Bus_t>(this->raw() >> Access_t::shift(n)));
+            }
+        }
 
         return *this;
     }
 
     auto read() -> decltype(*this)&
     {
-        this->raw() = m_reader();
+        using Access_t = BusAccess<Register_T>;
+
+        if constexpr (Access_t::count == 1)
+        {
+            this->raw() = m_reader();
+        }
+        else
+        {
+            auto value = Value_t{0};
+            for (const auto n : Access_t::sequence)
+            {
+                value |= static_cast<Value_t>(m_reader(Access_t::address(n))) << Access_t::shift(n);
+            }
+
+            this->raw() = value;
+        }
+
         return *this;
     }
 
@@ -100,14 +206,23 @@ using Any64BitAddress = AnyAddress<uint64_t>;
 /// <summary>
 /// A register address.
 /// </summary>
-/// <typeparam name="Value_T">The type of the register (e.g. uint32_t)</typeparam>
 /// <typeparam name="BaseRange_T">The base address range for the register.</typeparam>
-template<typename BaseRange_T, typename BaseRange_T::Value_t OFFSET, typename Value_T = typename BaseRange_T::Value_t>
+/// <typeparam name="Value_T">The type of the register (e.g. uint32_t)</typeparam>
+/// <typeparam name="ENDIANNESS">The byte order of the register value on the bus.</typeparam>
+/// <typeparam name="Bus_T">The type of a single bus access. Registers wider than this are split into several accesses.</typeparam>
+/// <typeparam name="WORD_ORDER">The order of the accesses when the register is wider than the bus.</typeparam>
+template<typename BaseRange_T,
+         typename BaseRange_T::Value_t OFFSET,
+         typename Value_T       = typename BaseRange_T::Value_t,
+         std::endian ENDIANNESS = std::endian::native,
+         typename Bus_T         = Value_T,
+         WordOrder WORD_ORDER   = WordOrder::least_significant_first>
 class RegisterAddress
 {
 public:
     using Value_t  = Value_T;
     using Offset_t = typename BaseRange_T::Value_t;
+    using Bus_t    = Bus_T;
 
     static constexpr Offset_t base    = BaseRange_T::begin;
     static constexpr Offset_t offset  = OFFSET;
@@ -115,6 +230,13 @@ public:
 
     static constexpr size_t size = sizeof(Value_t);
 
+    static constexpr std::endian byte_order = ENDIANNESS;
+    static constexpr WordOrder word_order   = WORD_ORDER;
+
+    static_assert(std::is_integral_v<Bus_t> && std::is_unsigned_v<Bus_t>, "A bus word must be an unsigned integral type");
+    static_assert(sizeof(Bus_t) <= sizeof(Value_t), "Bus is wider than the register");
+    static_assert(sizeof(Value_t) % sizeof(Bus_t) == 0, "Register width is not a whole number of bus words");
+
     static_assert(static_cast<uint64_t>(address) >= static_cast<uint64_t>(BaseRange_T::begin), "Register address is outside of it base range");
     static_assert(static_cast<uint64_t>(address) < static_cast<uint64_t>(BaseRange_T::end), "Register address is outside fof it base range");
 };
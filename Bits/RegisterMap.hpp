@@ -0,0 +1,168 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Register.hpp"
+
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// The layout of the bit ranges in a register. Compilation fails if any of the bit ranges overlap, or aren't in the register.
+/// </summary>
+/// <typeparam name="Register_T">The register address type.</typeparam>
+/// <typeparam name="Fields_T">All the bit ranges that are defined for the register.</typeparam>
+template<typename Register_T, typename... Fields_T>
+struct RegisterLayout
+{
+    using Register_t = Register_T;
+    using Value_t    = typename Register_T::Value_t;
+
+    static constexpr size_t field_count = sizeof...(Fields_T);
+
+    static_assert((std::is_same_v<Register_T, typename Fields_T::Register_t> && ...), "Bit range is not in the register");
+
+    /// The bits that are part of a bit range.
+    static constexpr Value_t used_mask = static_cast<Value_t>((Value_t{0} | ... | Fields_T::mask));
+
+    /// The bits that aren't part of any bit range.
+    static constexpr Value_t reserved_mask = static_cast<Value_t>(~used_mask);
+
+    /// Whether any two bit ranges share a bit. They do if the total number of bits in the ranges is more than the number of bits used.
+    static constexpr bool has_overlap = (0 + ... + std::popcount(Fields_T::mask)) != std::popcount(used_mask);
+
+    static_assert(!has_overlap, "Bit ranges in the register overlap");
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// The details of a single register in a RegisterMap.
+/// </summary>
+struct RegisterMapEntry
+{
+    uint64_t address;
+    size_t size;
+    size_t field_count;
+    uint64_t used_mask;
+    uint64_t reserved_mask;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Sort the entries of a register map by address. This only depends on the number of registers, not the types in the map, so the
+/// sorting code is shared between maps of the same size, and doesn't have to drag the whole map type around while it's instantiated.
+/// </summary>
+template<size_t N>
+constexpr std::array<RegisterMapEntry, N> SortByAddress(std::array<RegisterMapEntry, N> entries)
+{
+    std::sort(entries.begin(), entries.end(), [](const RegisterMapEntry& a, const RegisterMapEntry& b) { return a.address < b.address; });
+    return entries;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Whether any two entries of an address-sorted register map have the same address. Like SortByAddress, this only depends on the
+/// number of registers.
+/// </summary>
+template<size_t N>
+constexpr bool HasDuplicateAddress(const std::array<RegisterMapEntry, N>& entries)
+{
+    return std::adjacent_find(entries.begin(), entries.end(), [](const RegisterMapEntry& a, const RegisterMapEntry& b) {
+               return a.address == b.address;
+           }) != entries.end();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Find the index of the entry with the specified address in an address-sorted register map.
+/// </summary>
+/// <returns>The index of the entry, or N if there isn't one at the address.</returns>
+template<size_t N>
+constexpr size_t FindAddress(const std::array<RegisterMapEntry, N>& entries, uint64_t address)
+{
+    const auto it = std::lower_bound(entries.begin(), entries.end(), address, [](const RegisterMapEntry& e, uint64_t a) { return e.address < a; });
+    return it != entries.end() && it->address == address ? static_cast<size_t>(std::distance(entries.begin(), it)) : N;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// A map of all the registers of a device, and the bit ranges in them. Compilation fails if two registers have the same address. The
+/// registers are listed in a table, sorted by address, that can be used to group accesses to registers that are next to each other.
+/// </summary>
+/// <typeparam name="Layouts_T">The RegisterLayout of each register in the map.</typeparam>
+template<typename... Layouts_T>
+struct RegisterMap
+{
+    using Entry = RegisterMapEntry;
+
+    static constexpr size_t register_count = sizeof...(Layouts_T);
+
+    /// The value returned by find() when there is no register at the address.
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    /// All the registers in the map, sorted by address.
+    static constexpr std::array<Entry, register_count> table = SortByAddress<register_count>({Entry{static_cast<uint64_t>(Layouts_T::Register_t::address),
+                                                                                                   Layouts_T::Register_t::size,
+                                                                                                   Layouts_T::field_count,
+                                                                                                   static_cast<uint64_t>(Layouts_T::used_mask),
+                                                                                                   static_cast<uint64_t>(Layouts_T::reserved_mask)}...});
+
+    /// Whether any two registers have the same address. Since the table is sorted, only neighbouring registers need to be compared.
+    static constexpr bool has_aliased_address = HasDuplicateAddress<register_count>(table);
+
+    static_assert(!has_aliased_address, "Two registers in the map have the same address");
+
+    static constexpr size_t field_count = (size_t{0} + ... + Layouts_T::field_count);
+
+    /// <summary>
+    /// Find the index in the table of the register at the specified address.
+    /// </summary>
+    /// <returns>The index of the register, or npos if there isn't one at the address.</returns>
+    static constexpr size_t find(uint64_t address)
+    {
+        const auto index = FindAddress<register_count>(table, address);
+        return index != register_count ? index : npos;
+    }
+
+    /// <summary>
+    /// The number of registers, starting at index in the table, that each start where the previous one ends, and so can be accessed in
+    /// a single burst. This assumes that addresses count bytes, so that a register takes up its size in addresses.
+    /// </summary>
+    static constexpr size_t burst_length(size_t index)
+    {
+        if (index >= register_count)
+        {
+            return 0;
+        }
+
+        auto last = index;
+        while (last + 1 < register_count && table[last].address + table[last].size == table[last + 1].address)
+        {
+            ++last;
+        }
+
+        return 1 + last - index;
+    }
+
+    /// <summary>
+    /// The index in the table of a register. Compilation fails if the register isn't in the map.
+    /// </summary>
+    template<typename Register_T>
+    static constexpr size_t index_of()
+    {
+        static_assert((std::is_same_v<Register_T, typename Layouts_T::Register_t> || ...), "Register is not in the map");
+
+        return find(static_cast<uint64_t>(Register_T::address));
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,215 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Register.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <utility>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Watches bit ranges in many registers and calls back when their values change. Subscriptions are grouped by register, so each
+/// register is read once per scan, however many bit ranges in it are subscribed to. The changed bits of a register are found with a
+/// single XOR against its previous value, masked by the union of the masks of its subscriptions; only registers with changed bits
+/// have their subscriptions looked at. The callbacks for a scan are called together, once all the registers have been read.
+/// </summary>
+class RegisterMonitor
+{
+public:
+    using SubscriptionId = size_t;
+
+    /// <summary>
+    /// The type of the callback for a subscription to BitRange_T. It is called with the previous and current values of the bit range.
+    /// </summary>
+    template<typename BitRange_T>
+    using Callback = std::function<void(decltype(std::declval<RegisterValue<typename BitRange_T::Register_t>>().template get<BitRange_T>()),
+                                        decltype(std::declval<RegisterValue<typename BitRange_T::Register_t>>().template get<BitRange_T>()))>;
+
+    /// <summary>
+    /// Add a register to the set of registers that are read on each scan.
+    /// </summary>
+    /// <typeparam name="Register_T">The register address type of the register to watch.</typeparam>
+    /// <param name="reader">The function used to read the register.</param>
+    template<typename Register_T>
+    void watch(typename Register<Register_T>::Reader reader)
+    {
+        static_assert(sizeof(typename Register_T::Value_t) <= sizeof(Wire_t), "Register is too wide to be monitored");
+
+        const auto address = static_cast<uint64_t>(Register_T::address);
+        if (find(address, type_id<Register_T>()) != m_registers.end())
+        {
+            throw std::invalid_argument("Register is already being watched");
+        }
+
+        auto reg = Register<Register_T>{reader, typename Register<Register_T>::Writer{}};
+        m_registers.insert(lower_bound(address),
+                           WatchedRegister{address, type_id<Register_T>(), [reg]() mutable { return static_cast<Wire_t>(reg.read().raw()); }});
+    }
+
+    /// <summary>
+    /// Subscribe to changes in the value of a bit range. The register that the bit range is in must already be watched.
+    /// </summary>
+    /// <typeparam name="BitRange_T">The bit range to subscribe to.</typeparam>
+    /// <param name="callback">Called with the previous and current values of the bit range when it changes.</param>
+    /// <returns>An ID that can be used to unsubscribe.</returns>
+    template<typename BitRange_T>
+    SubscriptionId subscribe(Callback<BitRange_T> callback)
+    {
+        using Register_t = typename BitRange_T::Register_t;
+        using Value_t    = typename Register_t::Value_t;
+
+        const auto it = find(static_cast<uint64_t>(Register_t::address), type_id<Register_t>());
+        if (it == m_registers.end())
+        {
+            throw std::invalid_argument("Register of the bit range is not being watched");
+        }
+
+        const auto id = m_next_id++;
+        it->subscriptions.push_back(Subscription{id, static_cast<Wire_t>(BitRange_T::wire_mask), [callback](Wire_t previous, Wire_t current) {
+                                                     const auto prev = RegisterValue<Register_t>{static_cast<Value_t>(previous)};
+                                                     const auto curr = RegisterValue<Register_t>{static_cast<Value_t>(current)};
+                                                     callback(prev.template get<BitRange_T>(), curr.template get<BitRange_T>());
+                                                 }});
+        it->mask |= BitRange_T::wire_mask;
+
+        return id;
+    }
+
+    /// <summary>
+    /// Remove a subscription. Its callback won't be called again.
+    /// </summary>
+    void unsubscribe(SubscriptionId id)
+    {
+        for (auto& reg : m_registers)
+        {
+            const auto it = std::find_if(reg.subscriptions.begin(), reg.subscriptions.end(), [id](const auto& s) { return s.id == id; });
+            if (it != reg.subscriptions.end())
+            {
+                reg.subscriptions.erase(it);
+
+                reg.mask = Wire_t{0};
+                for (const auto& s : reg.subscriptions)
+                {
+                    reg.mask |= s.mask;
+                }
+
+                return;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Read every watched register once and call the callbacks of the subscriptions whose bit ranges have changed since the last scan.
+    /// The first scan of a register only records its value. Callbacks must not subscribe or unsubscribe.
+    /// </summary>
+    void scan()
+    {
+        m_pending.clear();
+
+        for (auto& reg : m_registers)
+        {
+            const auto current = reg.read();
+            const auto changed = (current ^ reg.shadow) & reg.mask;
+
+            if (changed != 0 && reg.is_primed)
+            {
+                for (const auto& s : reg.subscriptions)
+                {
+                    if ((changed & s.mask) != 0)
+                    {
+                        m_pending.push_back(Notification{&s.dispatch, reg.shadow, current});
+                    }
+                }
+            }
+
+            reg.shadow    = current;
+            reg.is_primed = true;
+        }
+
+        for (const auto& n : m_pending)
+        {
+            (*n.dispatch)(n.previous, n.current);
+        }
+    }
+
+    size_t register_count() const { return m_registers.size(); }
+
+private:
+    using Wire_t = uint64_t;
+
+    /// Identifies a register type, so that different register types at the same address are kept apart.
+    using TypeId = const void*;
+
+    template<typename Register_T>
+    struct TypeTag
+    {
+        static constexpr char tag = 0;
+    };
+
+    template<typename Register_T>
+    static TypeId type_id()
+    {
+        return &TypeTag<Register_T>::tag;
+    }
+
+    struct Subscription
+    {
+        SubscriptionId id;
+        Wire_t mask;
+        std::function<void(Wire_t, Wire_t)> dispatch;
+    };
+
+    struct WatchedRegister
+    {
+        WatchedRegister(uint64_t address_, TypeId type_, std::function<Wire_t()> read_)
+            : address{address_}
+            , type{type_}
+            , read{std::move(read_)}
+        {
+        }
+
+        uint64_t address;
+        TypeId type;
+        std::function<Wire_t()> read;
+        Wire_t shadow  = Wire_t{0};
+        Wire_t mask    = Wire_t{0};
+        bool is_primed = false;
+        std::vector<Subscription> subscriptions;
+    };
+
+    struct Notification
+    {
+        const std::function<void(Wire_t, Wire_t)>* dispatch;
+        Wire_t previous;
+        Wire_t current;
+    };
+
+    std::vector<WatchedRegister>::iterator lower_bound(uint64_t address)
+    {
+        return std::lower_bound(m_registers.begin(), m_registers.end(), address, [](const auto& reg, uint64_t a) { return reg.address < a; });
+    }
+
+    std::vector<WatchedRegister>::iterator find(uint64_t address, TypeId type)
+    {
+        for (auto it = lower_bound(address); it != m_registers.end() && it->address == address; ++it)
+        {
+            if (it->type == type)
+            {
+                return it;
+            }
+        }
+
+        return m_registers.end();
+    }
+
+    std::vector<WatchedRegister> m_registers;
+    std::vector<Notification> m_pending;
+    SubscriptionId m_next_id = SubscriptionId{0};
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -2,12 +2,17 @@
 
 #include <Bits/Bitmask.hpp>
 #include <Bits/Register.hpp>
+#include <Bits/RegisterMap.hpp>
+#include <Bits/RegisterMonitor.hpp>
 
 #include <bitset>
 #include <string>
 #include <algorithm>
 #include <random>
 #include <cmath>
+#include <vector>
+#include <utility>
+#include <bit>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -361,6 +366,83 @@ public:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+TEST_CLASS (TestRangePolicy)
+{
+public:
+    using TestRegRange = RegisterBaseAddressRange<uint32_t, 0x00000000, 0x00001000>;
+    using TestRegister = RegisterAddress<TestRegRange, 0x20>;
+
+    using field = bitmask::Bitrange<TestRegister, 4, 7>;
+    using upper = bitmask::Bitrange<TestRegister, 8, 31>;
+
+    TEST_METHOD(MaxIsLargestValueThatFits)
+    {
+        static_assert(field::max_value == 15);
+        static_assert(field::max() == 15);
+
+        Assert::AreEqual(uint64_t{15}, field::max());
+        Assert::AreEqual(uint64_t{0xFFFFFFFF}, bitmask::Bitrange<TestRegister, 0, 31>::max());
+    }
+
+    TEST_METHOD(UncheckedDropsExtraBits)
+    {
+        auto reg_val = RegisterValue<TestRegister>{0};
+        reg_val.set<field, bitmask::Unchecked>(0x1F);
+
+        Assert::AreEqual(uint32_t{0xF}, reg_val.get<field>());
+        Assert::AreEqual(uint32_t{0}, reg_val.get<upper>());
+    }
+
+    TEST_METHOD(SaturateClampsToMax)
+    {
+        auto reg_val = RegisterValue<TestRegister>{0};
+
+        reg_val.set<field, bitmask::Saturate>(0x10);
+        Assert::AreEqual(uint32_t{0xF}, reg_val.get<field>());
+        Assert::AreEqual(uint32_t{0}, reg_val.get<upper>());
+
+        reg_val.set<field, bitmask::Saturate>(0x9);
+        Assert::AreEqual(uint32_t{0x9}, reg_val.get<field>());
+    }
+
+    TEST_METHOD(TruncateAndCountCountsValuesThatDontFit)
+    {
+        using counted = bitmask::Bitrange<TestRegister, 0, 3>;
+
+        auto reg_val = RegisterValue<TestRegister>{0};
+
+        reg_val.set<counted, bitmask::TruncateAndCount>(0x15);
+        reg_val.set<counted, bitmask::TruncateAndCount>(0x0F);
+        reg_val.set<field, bitmask::TruncateAndCount>(0x15);
+
+        Assert::AreEqual(uint32_t{0xF}, reg_val.get<counted>());
+        Assert::AreEqual(uint64_t{1}, bitmask::TruncateAndCount::count<counted>.load());
+    }
+
+    TEST_METHOD(ThrowOutOfRangeThrowsOnlyWhenValueDoesntFit)
+    {
+        auto reg_val = RegisterValue<TestRegister>{0};
+
+        reg_val.set<field, bitmask::ThrowOutOfRange>(0xF);
+        Assert::AreEqual(uint32_t{0xF}, reg_val.get<field>());
+
+        Assert::ExpectException<std::out_of_range>([&reg_val]() { reg_val.set<field, bitmask::ThrowOutOfRange>(0x10); });
+        Assert::AreEqual(uint32_t{0xF}, reg_val.get<field>());
+    }
+
+    TEST_METHOD(MaxValueIsAccepted)
+    {
+        auto reg_val = RegisterValue<TestRegister>{0};
+        reg_val.set<field>(15);
+        reg_val.set<upper, 0xFFFFFF>();
+
+        Assert::AreEqual(uint8_t{15}, reg_val.get<field, uint8_t>());
+        Assert::AreEqual(uint32_t{0xFFFFFFF0}, reg_val.raw());
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 TEST_CLASS (TestRegister)
 {
 public:
@@ -382,6 +464,357 @@ public:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+TEST_CLASS (TestRegisterByteOrder)
+{
+public:
+    using TestRegRange = RegisterBaseAddressRange<uint32_t, 0x00000000, 0x00001000>;
+
+    static constexpr auto foreign_endian = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+
+    using ForeignRegister_32 = RegisterAddress<TestRegRange, 0x20, uint32_t, foreign_endian>;
+    using WideRegister_LSW   = RegisterAddress<TestRegRange, 0x40, uint64_t, std::endian::native, uint32_t, WordOrder::least_significant_first>;
+    using WideRegister_MSW   = RegisterAddress<TestRegRange, 0x40, uint64_t, std::endian::native, uint32_t, WordOrder::most_significant_first>;
+
+    TEST_METHOD(ByteSwap)
+    {
+        Assert::AreEqual(uint8_t{0x12}, bitmask::ByteSwap(uint8_t{0x12}));
+        Assert::AreEqual(uint16_t{0x3412}, bitmask::ByteSwap(uint16_t{0x1234}));
+        Assert::AreEqual(uint32_t{0x78563412}, bitmask::ByteSwap(uint32_t{0x12345678}));
+        Assert::AreEqual(uint64_t{0xEFCDAB8967452301}, bitmask::ByteSwap(uint64_t{0x0123456789ABCDEF}));
+    }
+
+    TEST_METHOD(WireMaskIsByteSwapped)
+    {
+        using field = bitmask::Bitrange<ForeignRegister_32, 4, 11>;
+
+        Assert::AreEqual(uint32_t{0x00000FF0}, field::mask);
+        Assert::AreEqual(uint32_t{0xF00F0000}, field::wire_mask);
+        Assert::IsFalse(field::is_wire_contiguous);
+    }
+
+    TEST_METHOD(GetValueFromForeignByteOrder)
+    {
+        const auto host_val = uint32_t{0xC0F85879};
+        const auto reg_val  = RegisterValue<ForeignRegister_32>{bitmask::ByteSwap(host_val)};
+
+        using within_byte = bitmask::Bitrange<ForeignRegister_32, 25, 29>;
+        using across_byte = bitmask::Bitrange<ForeignRegister_32, 3, 20>;
+        using flag        = bitmask::SingleBit<ForeignRegister_32, 31>;
+
+        Assert::IsTrue(within_byte::is_wire_contiguous);
+        Assert::AreEqual(bitmask::GetValue<within_byte>(host_val), reg_val.get<within_byte>());
+        Assert::AreEqual(bitmask::GetValue<across_byte>(host_val), reg_val.get<across_byte>());
+        Assert::AreEqual(true, reg_val.get<flag>());
+        Assert::AreEqual(host_val, reg_val.value());
+    }
+
+    TEST_METHOD(SetValueInForeignByteOrder)
+    {
+        auto reg_val = RegisterValue<ForeignRegister_32>{0};
+
+        using within_byte = bitmask::Bitrange<ForeignRegister_32, 25, 29>;
+        using across_byte = bitmask::Bitrange<ForeignRegister_32, 3, 20>;
+
+        reg_val.set<within_byte>(0x15);
+        reg_val.set<across_byte>(0x2ABCD);
+
+        auto expected = uint32_t{0};
+        bitmask::SetValue<within_byte>(expected, uint32_t{0x15});
+        bitmask::SetValue<across_byte>(expected, uint32_t{0x2ABCD});
+
+        Assert::AreEqual(bitmask::ByteSwap(expected), reg_val.raw());
+        Assert::AreEqual(expected, reg_val.value());
+    }
+
+    TEST_METHOD(WideRegisterIsReadInNarrowAccesses)
+    {
+        auto accesses = std::vector<uint32_t>{};
+        auto reader   = Register<WideRegister_LSW>::Reader{[&accesses](uint32_t address) {
+            accesses.push_back(address);
+            return address == WideRegister_LSW::address ? uint32_t{0x89ABCDEF} : uint32_t{0x01234567};
+        }};
+        auto writer   = Register<WideRegister_LSW>::Writer{[](uint32_t, uint32_t) {}};
+
+        auto reg = Register<WideRegister_LSW>{reader, writer};
+        reg.read();
+
+        Assert::IsTrue(std::vector<uint32_t>{0x40, 0x44} == accesses);
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            Assert::AreEqual(uint64_t{0x0123456789ABCDEF}, reg.raw());
+        }
+    }
+
+    TEST_METHOD(WideRegisterIsWrittenInPolicyOrder)
+    {
+        auto accesses = std::vector<std::pair<uint32_t, uint32_t>>{};
+        auto reader   = Register<WideRegister_MSW>::Reader{[](uint32_t) { return uint32_t{0}; }};
+        auto writer   = Register<WideRegister_MSW>::Writer{[&accesses](uint32_t address, uint32_t v) { accesses.emplace_back(address, v); }};
+
+        auto reg = Register<WideRegister_MSW>{reader, writer};
+        reg.write(uint64_t{0x0123456789ABCDEF});
+
+        Assert::AreEqual(size_t{2}, accesses.size());
+        Assert::AreEqual(uint32_t{0x44}, accesses[0].first);
+        Assert::AreEqual(uint32_t{0x40}, accesses[1].first);
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            Assert::AreEqual(uint32_t{0x01234567}, accesses[0].second);
+            Assert::AreEqual(uint32_t{0x89ABCDEF}, accesses[1].second);
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST_CLASS (TestEncoder)
+{
+public:
+    using TestRegRange = RegisterBaseAddressRange<uint32_t, 0x00000000, 0x00001000>;
+
+    static constexpr auto foreign_endian = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+
+    using Waveform        = RegisterAddress<TestRegRange, 0x20>;
+    using ForeignWaveform = RegisterAddress<TestRegRange, 0x24, uint32_t, foreign_endian>;
+
+    template<typename Register_T>
+    static void EncodeMatchesSet()
+    {
+        using Amplitude = bitmask::Bitrange<Register_T, 0, 11>;
+        using Phase     = bitmask::Bitrange<Register_T, 12, 27>;
+        using Enable    = bitmask::SingleBit<Register_T, 31>;
+
+        std::default_random_engine rng(4096); // Arbitrary seed.
+        std::uniform_int_distribution<uint32_t> uniform_dist{};
+
+        const auto count = size_t{37};
+        auto amplitudes  = std::vector<uint16_t>(count);
+        auto phases      = std::vector<uint16_t>(count);
+        auto enables     = std::vector<uint8_t>(count);
+        for (auto i = size_t{0}; i < count; ++i)
+        {
+            amplitudes[i] = static_cast<uint16_t>(uniform_dist(rng) & 0xFFF);
+            phases[i]     = static_cast<uint16_t>(uniform_dist(rng));
+            enables[i]    = static_cast<uint8_t>(uniform_dist(rng) & 1);
+        }
+
+        auto words = std::vector<uint32_t>(count, 0xFFFFFFFF);
+        bitmask::Encoder<Amplitude, Phase, Enable>::encode(words, amplitudes, phases, enables);
+
+        for (auto i = size_t{0}; i < count; ++i)
+        {
+            auto expected = RegisterValue<Register_T>{0};
+            expected.template set<Amplitude>(amplitudes[i]);
+            expected.template set<Phase>(phases[i]);
+            expected.template set<Enable>(enables[i] != 0);
+
+            Assert::AreEqual(expected.raw(), words[i]);
+        }
+    }
+
+    TEST_METHOD(EncodeMatchesSet_NativeByteOrder) { EncodeMatchesSet<Waveform>(); }
+    TEST_METHOD(EncodeMatchesSet_ForeignByteOrder) { EncodeMatchesSet<ForeignWaveform>(); }
+
+    TEST_METHOD(EncodeSetsSingleBitForAnyNonZeroValue)
+    {
+        using Enable = bitmask::SingleBit<Waveform, 31>;
+
+        const auto enables = std::vector<uint8_t>{0, 1, 2, 0x80, 0xFF};
+        auto words         = std::vector<uint32_t>(enables.size());
+
+        bitmask::Encoder<Enable>::encode(words, enables);
+
+        for (auto i = size_t{0}; i < enables.size(); ++i)
+        {
+            auto expected = RegisterValue<Waveform>{0};
+            expected.set<Enable>(enables[i] != 0);
+
+            Assert::AreEqual(expected.raw(), words[i]);
+        }
+
+        Assert::IsTrue(std::vector<uint32_t>{0x00000000, 0x80000000, 0x80000000, 0x80000000, 0x80000000} == words);
+    }
+
+    TEST_METHOD(EncodeAppliesRangePolicy)
+    {
+        using Amplitude = bitmask::Bitrange<Waveform, 4, 7>;
+
+        const auto amplitudes = std::vector<uint32_t>{0x3, 0xF, 0x10, 0xFFFF};
+        auto words            = std::vector<uint32_t>(amplitudes.size());
+
+        const auto encoded = bitmask::Encoder<Amplitude>::encode<bitmask::Saturate>(words, amplitudes);
+
+        Assert::AreEqual(words.size(), encoded.size());
+        Assert::IsTrue(std::vector<uint32_t>{0x30, 0xF0, 0xF0, 0xF0} == words);
+    }
+
+    TEST_METHOD(EncodeAppliesRangePolicyBeforeNarrowingWideInputs)
+    {
+        using Amplitude = bitmask::Bitrange<Waveform, 4, 7>;
+
+        const auto amplitudes = std::vector<uint64_t>{0x3, 0x1'0000'0005};
+        auto words            = std::vector<uint32_t>(amplitudes.size());
+
+        bitmask::Encoder<Amplitude>::encode<bitmask::Saturate>(words, amplitudes);
+        Assert::IsTrue(std::vector<uint32_t>{0x30, 0xF0} == words);
+
+        Assert::ExpectException<std::out_of_range>([&]() { bitmask::Encoder<Amplitude>::encode<bitmask::ThrowOutOfRange>(words, amplitudes); });
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST_CLASS (TestRegisterMonitor)
+{
+public:
+    using TestRegRange = RegisterBaseAddressRange<uint32_t, 0x00000000, 0x00001000>;
+    using Status_1     = RegisterAddress<TestRegRange, 0x20>;
+    using Status_2     = RegisterAddress<TestRegRange, 0x10>;
+
+    using Error_1 = bitmask::SingleBit<Status_1, 0>;
+    using Level_1 = bitmask::Bitrange<Status_1, 4, 7>;
+    using Error_2 = bitmask::SingleBit<Status_2, 31>;
+
+    TEST_METHOD(EachRegisterIsReadOncePerScan)
+    {
+        auto reads   = std::vector<uint32_t>{};
+        auto monitor = RegisterMonitor{};
+        monitor.watch<Status_1>([&reads]() { reads.push_back(Status_1::address); return uint32_t{0}; });
+        monitor.watch<Status_2>([&reads]() { reads.push_back(Status_2::address); return uint32_t{0}; });
+
+        monitor.subscribe<Error_1>([](bool, bool) {});
+        monitor.subscribe<Level_1>([](uint32_t, uint32_t) {});
+        monitor.subscribe<Error_2>([](bool, bool) {});
+
+        monitor.scan();
+
+        Assert::AreEqual(size_t{2}, monitor.register_count());
+        Assert::IsTrue(std::vector<uint32_t>{0x10, 0x20} == reads);
+    }
+
+    TEST_METHOD(OnlyChangedFieldsAreNotified)
+    {
+        auto value   = uint32_t{0};
+        auto monitor = RegisterMonitor{};
+        monitor.watch<Status_1>([&value]() { return value; });
+
+        auto errors = std::vector<std::pair<bool, bool>>{};
+        auto levels = std::vector<std::pair<uint32_t, uint32_t>>{};
+        monitor.subscribe<Error_1>([&errors](bool prev, bool curr) { errors.emplace_back(prev, curr); });
+        monitor.subscribe<Level_1>([&levels](uint32_t prev, uint32_t curr) { levels.emplace_back(prev, curr); });
+
+        monitor.scan();
+        Assert::IsTrue(errors.empty() && levels.empty());
+
+        value = 0x00000050;
+        monitor.scan();
+        Assert::IsTrue(errors.empty());
+        Assert::IsTrue((std::vector<std::pair<uint32_t, uint32_t>>{{0, 5}}) == levels);
+
+        // Bits outside all the subscribed ranges don't trigger callbacks.
+        value = 0x00000F51;
+        monitor.scan();
+        Assert::IsTrue((std::vector<std::pair<bool, bool>>{{false, true}}) == errors);
+        Assert::AreEqual(size_t{1}, levels.size());
+    }
+
+    TEST_METHOD(UnsubscribedCallbacksAreNotCalled)
+    {
+        auto value   = uint32_t{0};
+        auto monitor = RegisterMonitor{};
+        monitor.watch<Status_1>([&value]() { return value; });
+
+        auto calls = 0;
+        const auto id = monitor.subscribe<Error_1>([&calls](bool, bool) { ++calls; });
+        monitor.scan();
+
+        monitor.unsubscribe(id);
+        value = 1;
+        monitor.scan();
+
+        Assert::AreEqual(0, calls);
+    }
+
+    TEST_METHOD(SubscribingToUnwatchedRegisterThrows)
+    {
+        auto monitor = RegisterMonitor{};
+        Assert::ExpectException<std::invalid_argument>([&monitor]() { monitor.subscribe<Error_2>([](bool, bool) {}); });
+    }
+
+    TEST_METHOD(RegistersAreMatchedByTypeAsWellAsAddress)
+    {
+        using NarrowStatus_1 = RegisterAddress<TestRegRange, 0x20, uint16_t>;
+        using NarrowError_1  = bitmask::SingleBit<NarrowStatus_1, 0>;
+
+        auto monitor = RegisterMonitor{};
+        monitor.watch<Status_1>([]() { return uint32_t{0}; });
+
+        Assert::ExpectException<std::invalid_argument>([&monitor]() { monitor.subscribe<NarrowError_1>([](bool, bool) {}); });
+        Assert::ExpectException<std::invalid_argument>([&monitor]() { monitor.watch<Status_1>([]() { return uint32_t{0}; }); });
+
+        monitor.watch<NarrowStatus_1>([]() { return uint16_t{1}; });
+        monitor.subscribe<NarrowError_1>([](bool, bool) {});
+
+        Assert::AreEqual(size_t{2}, monitor.register_count());
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST_CLASS (TestRegisterMap)
+{
+public:
+    using TestRegRange = RegisterBaseAddressRange<uint32_t, 0x00000000, 0x00001000>;
+    using Control      = RegisterAddress<TestRegRange, 0x24>;
+    using Status       = RegisterAddress<TestRegRange, 0x20>;
+    using Counter      = RegisterAddress<TestRegRange, 0x40, uint64_t>;
+
+    using ControlLayout = RegisterLayout<Control, bitmask::SingleBit<Control, 0>, bitmask::Bitrange<Control, 4, 7>, bitmask::Bitrange<Control, 8, 15>>;
+    using StatusLayout  = RegisterLayout<Status, bitmask::SingleBit<Status, 31>>;
+    using CounterLayout = RegisterLayout<Counter, bitmask::Bitrange<Counter, 0, 47>>;
+
+    using Map = RegisterMap<ControlLayout, CounterLayout, StatusLayout>;
+
+    TEST_METHOD(LayoutMasks)
+    {
+        Assert::AreEqual(uint32_t{0x0000FFF1}, ControlLayout::used_mask);
+        Assert::AreEqual(uint32_t{0xFFFF000E}, ControlLayout::reserved_mask);
+        Assert::AreEqual(uint64_t{0xFFFF000000000000}, CounterLayout::reserved_mask);
+    }
+
+    TEST_METHOD(TableIsSortedByAddress)
+    {
+        Assert::AreEqual(size_t{3}, Map::register_count);
+        Assert::AreEqual(size_t{5}, Map::field_count);
+
+        Assert::AreEqual(uint64_t{0x20}, Map::table[0].address);
+        Assert::AreEqual(uint64_t{0x24}, Map::table[1].address);
+        Assert::AreEqual(uint64_t{0x40}, Map::table[2].address);
+        Assert::AreEqual(uint64_t{0x7FFFFFFF}, Map::table[0].reserved_mask);
+        Assert::AreEqual(size_t{8}, Map::table[2].size);
+    }
+
+    TEST_METHOD(FindRegisters)
+    {
+        static_assert(Map::index_of<Control>() == 1);
+        static_assert(Map::index_of<Status>() == 0);
+        static_assert(Map::index_of<Counter>() == 2);
+
+        Assert::AreEqual(size_t{2}, Map::find(0x40));
+        Assert::AreEqual(Map::npos, Map::find(0x30));
+    }
+
+    TEST_METHOD(BurstLength)
+    {
+        Assert::AreEqual(size_t{2}, Map::burst_length(0));
+        Assert::AreEqual(size_t{1}, Map::burst_length(1));
+        Assert::AreEqual(size_t{1}, Map::burst_length(2));
+        Assert::AreEqual(size_t{0}, Map::burst_length(3));
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 } // namespace test_bits
 
 ///////////////////////////////////////////////////////////////////////////////